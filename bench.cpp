@@ -0,0 +1,379 @@
+//---------------------------------------------------------------------------
+// bench.cpp
+//---------------------------------------------------------------------------
+// This code measures the storage options, node orderings and distance
+// oracle of GraphStore, GraphM and GraphL on generated graphs, and writes
+// the tables to "bench_output.txt".
+// It is not part of the lab and does not check any results.
+//
+// Build and run from this directory with, for example:
+//   g++ -std=c++17 -O2 graphm.cpp graphl.cpp graphstore.cpp
+//       distanceoracle.cpp nodedata.cpp bench.cpp -o bench
+//   ulimit -s unlimited && ./bench
+// depthFirstSearch() recurses once per node on a path, which needs more
+// stack than the usual 8 MB on the larger graphs.
+//
+// Assumptions:
+//   -- glibc, heap use is read with mallinfo2()
+//   -- the graphs are written to "bench_graph.txt" for buildGraph(),
+//      which is removed at the end
+//   -- text printed by the graph classes goes to a buffer that drops it,
+//      so times include formatting the output but not writing it
+//---------------------------------------------------------------------------
+
+#include <malloc.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "distanceoracle.h"
+#include "graphl.h"
+#include "graphm.h"
+#include "graphstore.h"
+using namespace std;
+using namespace std::chrono;
+
+const char* const OUTPUT_FILE = "bench_output.txt";
+const char* const GRAPH_FILE = "bench_graph.txt";
+const int QUERIES = 1000000;   // distance queries timed per row
+
+//---------------------------------------------------------------------------
+// NullBuffer accepts and drops everything written to it
+class NullBuffer : public streambuf {
+protected:
+	streamsize xsputn(const char*, streamsize n) override { return n; }
+	int overflow(int c) override { return c; }
+};
+
+//---------------------------------------------------------------------------
+// graphText: the input text for a graph with the given edges, in the
+// format read by buildGraph(), with weights if weighted is set
+string graphText(int size, const vector<string>& edges, bool weighted) {
+	stringstream ss;
+	ss << size << "\n";
+	for (int i = 1; i <= size; i++)
+		ss << "v" << i << "\n";
+	for (size_t i = 0; i < edges.size(); i++)
+		ss << edges[i];
+	ss << (weighted ? "0 0 0\n" : "0 0\n");
+	return ss.str();
+}
+
+//---------------------------------------------------------------------------
+// randomGraph: an unweighted graph where every node has degree edges
+// to random nodes, or with local set to nodes at most 200 numbers away.
+// The edges are listed in random order
+string randomGraph(int size, int degree, bool local, unsigned seed) {
+	mt19937 rng(seed);
+	vector<string> edges;
+	for (int u = 1; u <= size; u++) {
+		for (int i = 0; i < degree; i++) {
+			int v = local
+				? ((u - 1 + static_cast<int>(rng() % 401) - 200) % size
+				   + size) % size + 1
+				: static_cast<int>(rng() % size) + 1;
+			edges.push_back(to_string(u) + " " + to_string(v) + "\n");
+		}
+	}
+	shuffle(edges.begin(), edges.end(), rng);
+	return graphText(size, edges, false);
+}
+
+//---------------------------------------------------------------------------
+// gridGraph: a width x height grid with edges both ways between nodes
+// next to each other, weighted 1 to 9 if weighted is set. The nodes are
+// numbered, and the edges listed, in random order
+string gridGraph(int width, int height, bool weighted, unsigned seed) {
+	mt19937 rng(seed);
+	vector<int> node(width * height);
+	for (size_t i = 0; i < node.size(); i++)
+		node[i] = static_cast<int>(i) + 1;
+	shuffle(node.begin(), node.end(), rng);
+
+	const int DX[] = {1, -1, 0, 0};
+	const int DY[] = {0, 0, 1, -1};
+	vector<string> edges;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			for (int d = 0; d < 4; d++) {
+				int nx = x + DX[d];
+				int ny = y + DY[d];
+				if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+					continue;
+				string edge = to_string(node[y * width + x]) + " " +
+				              to_string(node[ny * width + nx]);
+				if (weighted)
+					edge += " " + to_string(rng() % 9 + 1);
+				edges.push_back(edge + "\n");
+			}
+		}
+	}
+	shuffle(edges.begin(), edges.end(), rng);
+	return graphText(width * height, edges, weighted);
+}
+
+//---------------------------------------------------------------------------
+// storeBytes: heap bytes held by a GraphStore built from text
+size_t storeBytes(const string& text, bool compressed) {
+	stringstream in(text);
+	struct mallinfo2 before = mallinfo2();
+	GraphStore store(false, compressed);
+	store.buildGraph(in);
+	struct mallinfo2 after = mallinfo2();
+	return (after.uordblks + after.hblkhd) -
+	       (before.uordblks + before.hblkhd);
+}
+
+//---------------------------------------------------------------------------
+// walkTime: milliseconds to visit every edge of a GraphStore once,
+// averaged over ten walks
+double walkTime(const string& text, bool compressed) {
+	stringstream in(text);
+	GraphStore store(false, compressed);
+	store.buildGraph(in);
+
+	long long sum = 0;
+	steady_clock::time_point start = steady_clock::now();
+	for (int r = 0; r < 10; r++) {
+		for (int n = 1; n <= store.getSize(); n++) {
+			for (GraphStore::Edge e : store.neighbors(n))
+				sum += e.adjNode;
+		}
+	}
+	double ms = duration<double, milli>(steady_clock::now() - start).count();
+	//uses sum so the walk can not be left out
+	return sum == -1 ? 0 : ms / 10;
+}
+
+//---------------------------------------------------------------------------
+// dfsTime: milliseconds for depthFirstSearch() on a GraphL built from
+// text, with the given options
+double dfsTime(const string& text, bool compressed,
+               GraphStore::Ordering ordering) {
+	ofstream(GRAPH_FILE) << text;
+	ifstream infile(GRAPH_FILE);
+	GraphL G(compressed, ordering);
+	G.buildGraph(infile);
+
+	steady_clock::time_point start = steady_clock::now();
+	G.depthFirstSearch();
+	return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+//---------------------------------------------------------------------------
+// pathTime: milliseconds for findShortestPath() on a GraphM built from
+// text, with the given ordering
+double pathTime(const string& text, GraphStore::Ordering ordering) {
+	ofstream(GRAPH_FILE) << text;
+	ifstream infile(GRAPH_FILE);
+	GraphM G(ordering);
+	G.buildGraph(infile);
+
+	steady_clock::time_point start = steady_clock::now();
+	G.findShortestPath();
+	return duration<double, milli>(steady_clock::now() - start).count();
+}
+
+//---------------------------------------------------------------------------
+// benchCompression: memory and speed of CSR and COMPRESSED rows, on
+// 300,000 nodes with 16 edges each to random or to nearby nodes
+void benchCompression(ostream& out) {
+	const int SIZE = 300000;
+	const int DEGREE = 16;
+
+	out << "Compressed adjacency, " << SIZE << " nodes, "
+	    << SIZE * DEGREE << " edges" << endl;
+	out << "                      edge bytes   full edge walk"
+	    << "   depthFirstSearch" << endl;
+	for (int local = 0; local < 2; local++) {
+		string text = randomGraph(SIZE, DEGREE, local, 1);
+		//the node data is the same either way, so an edgeless graph of
+		//the same size is taken off to leave only the edges
+		size_t nodes = storeBytes(graphText(SIZE, vector<string>(),
+		                                    false), false);
+		for (int compressed = 0; compressed < 2; compressed++) {
+			string name = string(compressed ? "compressed" : "CSR") +
+			              (local ? ", local" : ", random");
+			double mb = (storeBytes(text, compressed) - nodes) / 1e6;
+			out << "  " << left << setw(20) << name << right << fixed
+			    << setprecision(1) << setw(5) << mb << " MB"
+			    << setw(12) << walkTime(text, compressed) << " ms"
+			    << setw(15)
+			    << dfsTime(text, compressed, GraphStore::INPUT)
+			    << " ms" << endl;
+		}
+	}
+	out << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchOrdering: time taken under each Ordering by findShortestPath()
+// on a weighted 40 x 40 grid, and by depthFirstSearch() on an unweighted
+// 1000 x 1000 grid
+void benchOrdering(ostream& out) {
+	const char* const NAME[] = {"INPUT", "BFS", "RCM", "DEGREE"};
+	string weighted = gridGraph(40, 40, true, 3);
+	string unweighted = gridGraph(1000, 1000, false, 3);
+
+	out << "Node ordering, findShortestPath on a 40 x 40 grid, "
+	    << "depthFirstSearch on a 1000 x 1000 grid" << endl;
+	out << "           findShortestPath   depthFirstSearch"
+	    << "   DFS, compressed" << endl;
+	for (int o = GraphStore::INPUT; o <= GraphStore::DEGREE; o++) {
+		GraphStore::Ordering ordering = static_cast<GraphStore::Ordering>(o);
+		out << "  " << left << setw(7) << NAME[o] << right << fixed
+		    << setprecision(1) << setw(12) << pathTime(weighted, ordering)
+		    << " ms" << setw(16) << dfsTime(unweighted, false, ordering)
+		    << " ms" << setw(15) << dfsTime(unweighted, true, ordering)
+		    << " ms" << endl;
+	}
+	out << endl;
+}
+
+//---------------------------------------------------------------------------
+// randomPairs: count pairs of nodes from 1 to size
+vector<pair<int, int> > randomPairs(int size, int count, unsigned seed) {
+	mt19937 rng(seed);
+	vector<pair<int, int> > pairs(count);
+	for (int i = 0; i < count; i++) {
+		pairs[i].first = static_cast<int>(rng() % size) + 1;
+		pairs[i].second = static_cast<int>(rng() % size) + 1;
+	}
+	return pairs;
+}
+
+//---------------------------------------------------------------------------
+// queryTime: nanoseconds per call of distance() on graph over the pairs
+template <class Graph>
+double queryTime(const Graph& graph, const vector<pair<int, int> >& pairs) {
+	long long sum = 0;
+	steady_clock::time_point start = steady_clock::now();
+	for (size_t i = 0; i < pairs.size(); i++)
+		sum += graph.distance(pairs[i].first, pairs[i].second).upper;
+	double ns = duration<double, nano>(steady_clock::now() - start).count();
+	//uses sum so the queries can not be left out
+	return sum == -1 ? 0 : ns / pairs.size();
+}
+
+//---------------------------------------------------------------------------
+// oracleRow: writes the memory, build time and query time of an oracle
+// with the given number of landmarks, and its mean stretch against exact
+// if exact is not null
+void oracleRow(ostream& out, const GraphStore& store, int landmarks,
+               const vector<pair<int, int> >& pairs, const GraphM* exact) {
+	steady_clock::time_point start = steady_clock::now();
+	DistanceOracle oracle(store, landmarks);
+	double build = duration<double, milli>(steady_clock::now() - start)
+	               .count();
+
+	out << "  k=" << left << setw(4) << landmarks << right << fixed
+	    << setprecision(1) << setw(9) << oracle.getBytes() / 1e6 << " MB"
+	    << setw(10) << build << " ms" << setw(8)
+	    << queryTime(oracle, pairs) << " ns";
+
+	//stretch is the estimate over the exact distance, for pairs that
+	//have a path of length above 0
+	if (exact != nullptr) {
+		double stretch = 0;
+		int counted = 0;
+		for (size_t i = 0; i < pairs.size(); i++) {
+			int from = pairs[i].first;
+			int to = pairs[i].second;
+			int d = exact->distance(from, to).upper;
+			if (d == 0 || d == INT_MAX)
+				continue;
+			stretch += static_cast<double>(oracle.distance(from, to).upper)
+			           / d;
+			counted++;
+		}
+		out << "   mean stretch " << setprecision(2)
+		    << stretch / counted;
+	}
+	out << endl;
+}
+
+//---------------------------------------------------------------------------
+// benchOracle: the exact table against oracles with several numbers of
+// landmarks on a weighted 40 x 40 grid, then oracles alone on a 550 x
+// 550 grid, where the table would not fit in memory
+void benchOracle(ostream& out) {
+	string text = gridGraph(40, 40, true, 3);
+	stringstream in(text);
+	GraphStore store(true);
+	store.buildGraph(in);
+	int size = store.getSize();
+	vector<pair<int, int> > pairs = randomPairs(size, QUERIES, 5);
+
+	ofstream(GRAPH_FILE) << text;
+	ifstream infile(GRAPH_FILE);
+	GraphM exact;
+	exact.buildGraph(infile);
+	steady_clock::time_point start = steady_clock::now();
+	exact.findShortestPath();
+	double build = duration<double, milli>(steady_clock::now() - start)
+	               .count();
+	//each TableType entry holds a bool and two ints, 12 bytes
+	double mb = (size + 1.0) * (size + 1.0) * 12 / 1e6;
+
+	out << "Distance oracle, " << size << " node grid, " << QUERIES
+	    << " random queries" << endl;
+	out << "           memory        build      query" << endl;
+	out << "  exact " << fixed << setprecision(1) << setw(9) << mb
+	    << " MB" << setw(10) << build << " ms" << setw(8)
+	    << queryTime(exact, pairs) << " ns" << endl;
+	const int LANDMARKS[] = {4, 8, 16, 32};
+	for (int i = 0; i < 4; i++)
+		oracleRow(out, store, LANDMARKS[i], pairs, &exact);
+
+	//through GraphM, which adds loading the Snapshot to each query
+	GraphM G;
+	ifstream again(GRAPH_FILE);
+	G.buildGraph(again);
+	G.buildOracle(16);
+	out << "  GraphM::distance() with k=16: " << setprecision(1)
+	    << queryTime(G, pairs) << " ns" << endl;
+	out << endl;
+
+	text = gridGraph(550, 550, true, 3);
+	stringstream bigIn(text);
+	GraphStore big(true);
+	big.buildGraph(bigIn);
+	size = big.getSize();
+	pairs = randomPairs(size, QUERIES, 5);
+
+	out << "Distance oracle, " << size << " node grid, where the exact "
+	    << "table would take " << setprecision(0)
+	    << (size + 1.0) * (size + 1.0) * 12 / 1e9 << " GB" << endl;
+	oracleRow(out, big, 8, pairs, nullptr);
+	oracleRow(out, big, 16, pairs, nullptr);
+	out << endl;
+}
+
+int main() {
+	ofstream out(OUTPUT_FILE);
+	if (!out) {
+		cout << "File could not be opened." << endl;
+		return 1;
+	}
+
+	//the graph classes print to cout, which is dropped while timing
+	NullBuffer discard;
+	streambuf* console = cout.rdbuf(&discard);
+
+	benchCompression(out);
+	benchOrdering(out);
+	benchOracle(out);
+
+	cout.rdbuf(console);
+	remove(GRAPH_FILE);
+	cout << "Results written to " << OUTPUT_FILE << endl;
+	return 0;
+}
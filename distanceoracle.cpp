@@ -0,0 +1,215 @@
+/** --------------------- distanceoracle.cpp ----------------------------
+    10/18/2026
+    --------------------------------------------------------------------
+    Purpose - Implementation file for the DistanceOracle class, which
+    estimates shortest distances in graphs too large for GraphM's full
+    table.
+    --------------------------------------------------------------------
+    The store's edges are copied into forward and reversed rows once, so
+    distances from a landmark and distances to it can both be found by
+    the same Dijkstra's algorithm
+
+    Both distance tables keep the landmarks of a node next to each
+    other, so a query reads two short runs of memory per node
+
+    Sums and differences of distances are worked out in long long so
+    they can not overflow
+    -------------------------------------------------------------------- */
+
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "distanceoracle.h"
+
+using namespace std;
+
+/* --------------------------- Constructor -----------------------------
+   Description: chooses up to the given number of landmarks and finds
+   the distances to and from each of them
+   --------------------------------------------------------------------- */
+DistanceOracle::DistanceOracle(const GraphStore& store, int landmarks)
+    : size(store.getSize()), count(max(0, min(landmarks, size)))
+{
+    //copies the edges into forward rows and reversed rows
+    vector<int> start(size + 2, 0);
+    vector<int> rstart(size + 2, 0);
+    for(int n = 1; n <= size; n++)
+    {
+        for(GraphStore::Edge e : store.neighbors(n))
+        {
+            start[n + 1]++;
+            rstart[e.adjNode + 1]++;
+        }
+    }
+    for(int i = 1; i <= size + 1; i++)
+    {
+        start[i] += start[i - 1];
+        rstart[i] += rstart[i - 1];
+    }
+    vector<GraphStore::Edge> adj(start[size + 1]);
+    vector<GraphStore::Edge> radj(rstart[size + 1]);
+    vector<int> next(rstart.begin(), rstart.end() - 1);
+    for(int n = 1; n <= size; n++)
+    {
+        int i = start[n];
+        for(GraphStore::Edge e : store.neighbors(n))
+        {
+            adj[i++] = e;
+            GraphStore::Edge back = {n, e.weight};
+            radj[next[e.adjNode]++] = back;
+        }
+    }
+
+    toLandmark.assign(cell(size + 1, 0), INT_MAX);
+    fromLandmark.assign(cell(size + 1, 0), INT_MAX);
+    if(count == 0)
+    {
+        return;
+    }
+
+    //the first landmark is the node with the most edges
+    int chosen = 1;
+    for(int n = 2; n <= size; n++)
+    {
+        int edges = start[n + 1] - start[n] + rstart[n + 1] - rstart[n];
+        if(edges > start[chosen + 1] - start[chosen] +
+                   rstart[chosen + 1] - rstart[chosen])
+        {
+            chosen = n;
+        }
+    }
+
+    //closest holds each node's distance either way to its nearest
+    //landmark so far, the farthest node becomes the next landmark
+    vector<int> closest(size + 1, INT_MAX);
+    for(int k = 0; k < count; k++)
+    {
+        landmark.push_back(chosen);
+        dijkstra(start, adj, chosen, fromLandmark, k);
+        dijkstra(rstart, radj, chosen, toLandmark, k);
+
+        chosen = 0;
+        for(int n = 1; n <= size; n++)
+        {
+            closest[n] = min(closest[n], min(fromLandmark[cell(n, k)],
+                                             toLandmark[cell(n, k)]));
+            //landmarks are at distance 0 so are never chosen again
+            if(closest[n] > 0 &&
+               (chosen == 0 || closest[n] > closest[chosen]))
+            {
+                chosen = n;
+            }
+        }
+        if(chosen == 0)
+        {
+            //every node is a landmark or at distance 0 from one, the
+            //unused columns stay INT_MAX and so are never used
+            break;
+        }
+    }
+}
+
+
+/* --------------------------- distance() ------------------------------
+   Description: returns bounds on the shortest distance from one node
+   to another. Both are INT_MAX when the oracle can tell there is no
+   path, the upper bound alone is INT_MAX when no path was found
+   --------------------------------------------------------------------- */
+DistanceOracle::Estimate DistanceOracle::distance(int from, int to) const
+{
+    Estimate none = {INT_MAX, INT_MAX};
+    if(from == to)
+    {
+        Estimate same = {0, 0};
+        return same;
+    }
+    if(count == 0)
+    {
+        Estimate unknown = {0, INT_MAX};
+        return unknown;
+    }
+
+    const int* fromTo = &toLandmark[cell(from, 0)];
+    const int* toTo = &toLandmark[cell(to, 0)];
+    const int* fromFrom = &fromLandmark[cell(from, 0)];
+    const int* toFrom = &fromLandmark[cell(to, 0)];
+
+    long long lower = 0;
+    long long upper = INT_MAX;
+    for(int k = 0; k < count; k++)
+    {
+        //a path through the landmark
+        if(fromTo[k] != INT_MAX && toFrom[k] != INT_MAX)
+        {
+            upper = min(upper,
+                        static_cast<long long>(fromTo[k]) + toFrom[k]);
+        }
+
+        //the landmark reaches from, so it would reach to through it
+        if(fromFrom[k] != INT_MAX)
+        {
+            if(toFrom[k] == INT_MAX)
+            {
+                return none;
+            }
+            lower = max(lower,
+                        static_cast<long long>(toFrom[k]) - fromFrom[k]);
+        }
+
+        //to reaches the landmark, so from would reach it through to
+        if(toTo[k] != INT_MAX)
+        {
+            if(fromTo[k] == INT_MAX)
+            {
+                return none;
+            }
+            lower = max(lower, static_cast<long long>(fromTo[k]) - toTo[k]);
+        }
+    }
+
+    Estimate e = {static_cast<int>(lower), static_cast<int>(upper)};
+    return e;
+}
+
+
+/* -------------------------- dijkstra() -------------------------------
+   Description: finds the shortest distance from source to every node
+   over the given rows, writing them to column k of table
+   --------------------------------------------------------------------- */
+void DistanceOracle::dijkstra(const vector<int>& start,
+                              const vector<GraphStore::Edge>& adj,
+                              int source, vector<int>& table, int k) const
+{
+    //heap of (distance, node), a node may be in it more than once and
+    //only its closest entry is used
+    typedef pair<int, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry> > heap;
+
+    table[cell(source, k)] = 0;
+    heap.push(Entry(0, source));
+    while(!heap.empty())
+    {
+        Entry top = heap.top();
+        heap.pop();
+        int node = top.second;
+        if(top.first > table[cell(node, k)])
+        {
+            continue;
+        }
+
+        for(int i = start[node]; i < start[node + 1]; i++)
+        {
+            long long dist = static_cast<long long>(top.first) +
+                             adj[i].weight;
+            int& best = table[cell(adj[i].adjNode, k)];
+            if(dist < best)
+            {
+                best = static_cast<int>(dist);
+                heap.push(Entry(best, adj[i].adjNode));
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/** ---------------------- distanceoracle.h -----------------------------
+    10/18/2026
+    --------------------------------------------------------------------
+    Purpose - Header file for the DistanceOracle class, which estimates
+    shortest distances in graphs too large for GraphM's full table.
+    --------------------------------------------------------------------
+    DistanceOracle picks a few landmark nodes and stores the shortest
+    distance from each landmark to every node and from every node to
+    each landmark, found with Dijkstra's algorithm using a heap. This
+    takes 2 * landmarks * size ints, rather than the size * size
+    entries of a full table.
+
+    By the triangle inequality, for any landmark L
+
+        d(u, L) + d(L, v)          >= d(u, v)
+        d(L, v) - d(L, u)          <= d(u, v)
+        d(u, L) - d(v, L)          <= d(u, v)
+
+    so a query looks at each landmark once and returns the lowest upper
+    bound and the highest lower bound found. The upper bound is the
+    length of a real path through a landmark and is used as the
+    estimate, the difference between the bounds is its largest possible
+    error. More landmarks make the bounds tighter.
+
+    Landmarks are chosen farthest first: the first is the node with the
+    most edges, each next one the node farthest from those chosen so
+    far, which spreads them over the graph.
+
+    Nodes use the store's internal numbers. INT_MAX is used to represent
+    infinity, for distances and for bounds
+    -------------------------------------------------------------------- */
+
+#ifndef DISTANCEORACLE_H
+#define DISTANCEORACLE_H
+
+#include <vector>
+
+#include "graphstore.h"
+
+using namespace std;
+
+class DistanceOracle
+{
+public:
+    struct Estimate
+    {
+        int lower;             // the distance is at least this
+        int upper;             // length of a path found, the estimate
+    };
+
+/* --------------------------- Constructor -----------------------------
+   Description: chooses up to the given number of landmarks and finds
+   the distances to and from each of them
+   --------------------------------------------------------------------- */
+    DistanceOracle(const GraphStore& store, int landmarks);
+
+/* --------------------------- distance() ------------------------------
+   Description: returns bounds on the shortest distance from one node
+   to another. Both are INT_MAX when the oracle can tell there is no
+   path, the upper bound alone is INT_MAX when no path was found
+   --------------------------------------------------------------------- */
+    Estimate distance(int from, int to) const;
+
+/* --------------------------- getters ---------------------------------
+   Description: number of landmarks used and bytes used by the distance
+   tables
+   --------------------------------------------------------------------- */
+    int getLandmarks() const { return static_cast<int>(landmark.size()); }
+    size_t getBytes() const
+    {
+        return (toLandmark.size() + fromLandmark.size()) * sizeof(int);
+    }
+
+private:
+/* -------------------------- dijkstra() -------------------------------
+   Description: finds the shortest distance from source to every node
+   over the given rows, writing them to column k of table
+   --------------------------------------------------------------------- */
+    void dijkstra(const vector<int>& start, const vector<GraphStore::Edge>&
+                  adj, int source, vector<int>& table, int k) const;
+
+    // index of landmark k of a node in either table
+    size_t cell(int node, int k) const
+    {
+        return static_cast<size_t>(node) * count + k;
+    }
+
+    int size;                     // number of nodes in the graph
+    int count;                    // number of landmarks
+    vector<int> landmark;         // the landmark nodes
+    vector<int> toLandmark;       // d(node, landmark k) at node*count+k
+    vector<int> fromLandmark;     // d(landmark k, node) at node*count+k
+};
+
+#endif // DISTANCEORACLE_H
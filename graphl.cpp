@@ -1,15 +1,23 @@
 /** ------------------------- graphl.cpp -------------------------------
     Chaconne Tatum-Diehl 502A
     2/14/2019
-    2/18/2019
+    10/18/2026
     --------------------------------------------------------------------
     Purpose - Implementation file for the GraphL class, which implements
     an unweighted digraph using an adjacency list
     --------------------------------------------------------------------
-    GraphL uses an array of GraphNode structs to store the graph data.
-    Each GraphNode contains the head of list of EdgeNodes which store
-    information about which other nodes in the graph that GraphNode is
-    connected to
+    GraphL keeps its nodes and edges in an unweighted GraphStore. Each
+    node's neighbors are listed most recently inserted first, as with a
+    linked adjacency list, but are stored in contiguous rows
+
+    A GraphL can instead be made with compressed edges, which stores
+    each node's neighbors sorted and varint encoded for large graphs.
+    Neighbors are then listed, and traversed, in increasing input number
+    order whatever the Ordering
+
+    The nodes can also be renumbered when the graph is built to improve
+    locality. The traversal works in the store's internal numbers and
+    turns them back into input numbers only to print them
 
     A depth-first traversal is implemented using recursion
     -------------------------------------------------------------------- */
@@ -23,31 +31,11 @@
 using namespace std;
 
 /* --------------------- Default Constructor ---------------------------
-   Description: initializes size to 0
+   Description: creates an empty unweighted store, compressed if asked,
+   whose nodes are numbered internally by ordering
    --------------------------------------------------------------------- */
-GraphL::GraphL() : size(0){}
-
-
-/* -------------------------- Destructor -------------------------------
-   Description: releases memory dynamically allocated for EdgeNodes and
-   NodeDatas
-   --------------------------------------------------------------------- */
-GraphL::~GraphL()
-{
-    for(int i = 1; i <= size; i++)
-    {
-        EdgeNode* pWalk = nodes[i].edgeHead;
-        //deletes all EdgeNodes for each node
-        while(pWalk)
-        {
-            EdgeNode* temp = pWalk->nextEdge;
-            delete pWalk;
-            pWalk = temp;
-        }
-        //then deletes NodeData
-        delete nodes[i].data;
-    }
-}
+GraphL::GraphL(bool compressed, GraphStore::Ordering ordering)
+    : store(false, compressed, ordering){}
 
 
 /* -------------------------- buildGraph() -----------------------------
@@ -57,34 +45,8 @@ GraphL::~GraphL()
    --------------------------------------------------------------------- */
 void GraphL::buildGraph(ifstream& infile)
 {
-    infile >> size;
-    //discards newline
-    infile.get();
-
-    //dynamically allocates a new NodeData for each node using the node
-    //names from the file
-    for(int i = 1; i <= size; i++)
-    {
-        string temp;
-        getline(infile, temp);
-        NodeData* n = new NodeData(temp);
-        nodes[i].data = n;
-    }
-
-    //dynamically allocates a new EdgeNode for each connection in the file
-    //and adds it to the adjacency list of the appropriate node
-    int from, to;
-    while(infile >> from >> to)
-    {
-        if(from == 0)
-        {
-            break;
-        }
-        EdgeNode* e = new EdgeNode;
-        e->adjGraphNode = to;
-        e->nextEdge = nodes[from].edgeHead;
-        nodes[from].edgeHead = e;
-    }
+    store.buildGraph(infile);
+    visited.assign(store.getSize() + 1, false);
 }
 
 
@@ -95,20 +57,19 @@ void GraphL::buildGraph(ifstream& infile)
 void GraphL::displayGraph()
 {
     cout << "Graph:" << endl;
-    for(int i = 1; i <= size; i++)
+    for(int i = 1; i <= store.getSize(); i++)
     {
         stringstream ss;
         ss << "Node " << i;
-        cout << left << setw(13) << ss.str() << *(nodes[i].data) << endl
+        int node = store.getInternal(i);
+        cout << left << setw(13) << ss.str() << store.getData(node) << endl
              << endl;
 
         //displays each connection
-        EdgeNode* pWalk = nodes[i].edgeHead;
-        while(pWalk)
+        for(GraphStore::Edge e : store.neighbors(node))
         {
             cout << right << setw(6) << "edge" << " " << i << " "
-            << setw(2) << pWalk->adjGraphNode << endl;
-            pWalk = pWalk->nextEdge;
+            << setw(2) << store.getOriginal(e.adjNode) << endl;
         }
     }
     cout << endl;
@@ -124,7 +85,8 @@ void GraphL::displayGraph()
 void GraphL::depthFirstSearch()
 {
     cout << "Depth-first ordering: ";
-    if(size > 0)
+    visited.assign(store.getSize() + 1, false);
+    if(store.getSize() > 0)
     {
         depthFirstHelper(1);
     }
@@ -133,22 +95,35 @@ void GraphL::depthFirstSearch()
 
 
 /* ----------------------- depthFirstHelper() --------------------------
-   Description: recursive helper function for depthFirstSearch()
+   Description: helper function for depthFirstSearch(), traverses the
+   unvisited nodes reachable from the node numbered currNode in the
+   input. Does nothing if that node is not in the graph
    --------------------------------------------------------------------- */
 void GraphL::depthFirstHelper(int currNode)
 {
-    cout << currNode << " ";
-    nodes[currNode].visited = true;
+    if(store.hasNode(currNode))
+    {
+        depthFirstVisit(store.getInternal(currNode));
+    }
+}
+
+
+/* ----------------------- depthFirstVisit() ---------------------------
+   Description: recursive part of depthFirstHelper(), works on the
+   store's internal numbers
+   --------------------------------------------------------------------- */
+void GraphL::depthFirstVisit(int node)
+{
+    cout << store.getOriginal(node) << " ";
+    visited[node] = true;
 
     //looks for new unvisited nodes and recurses on each found
-    EdgeNode* pWalk = nodes[currNode].edgeHead;
-    while(pWalk)
+    for(GraphStore::Edge e : store.neighbors(node))
     {
-        if(!nodes[pWalk->adjGraphNode].visited)
+        if(!visited[e.adjNode])
         {
-            depthFirstHelper(pWalk->adjGraphNode);
+            depthFirstVisit(e.adjNode);
         }
-        pWalk = pWalk->nextEdge;
     }
 }
 
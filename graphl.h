@@ -1,15 +1,23 @@
 /** ------------------------- graphl.h ---------------------------------
     Chaconne Tatum-Diehl 502A
     2/14/2019
-    2/18/2019
+    10/18/2026
     --------------------------------------------------------------------
     Purpose - Header file for the GraphL class, which implements an
     unweighted digraph using an adjacency list
     --------------------------------------------------------------------
-    GraphL uses an array of GraphNode structs to store the graph data.
-    Each GraphNode contains the head of list of EdgeNodes which store
-    information about which other nodes in the graph that GraphNode is
-    connected to
+    GraphL keeps its nodes and edges in an unweighted GraphStore. Each
+    node's neighbors are listed most recently inserted first, as with a
+    linked adjacency list, but are stored in contiguous rows
+
+    A GraphL can instead be made with compressed edges, which stores
+    each node's neighbors sorted and varint encoded for large graphs.
+    Neighbors are then listed, and traversed, in increasing input number
+    order whatever the Ordering
+
+    The nodes can also be renumbered when the graph is built to improve
+    locality, see GraphStore::Ordering. Output always uses the numbers
+    from the input
 
     A depth-first traversal is implemented using recursion
     -------------------------------------------------------------------- */
@@ -17,41 +25,32 @@
 #ifndef GRAPHL_H
 #define GRAPHL_H
 
-#include "graphm.h"
+#include <vector>
+
 #include "nodedata.h"
+#include "graphstore.h"
 
 using namespace std;
 
 class GraphL
 {
 private:
-    struct EdgeNode;      // forward reference for the compiler
-    struct GraphNode
-    {    // structs used for simplicity, use classes if desired
-        EdgeNode* edgeHead = nullptr; // head of the list of edges
-        NodeData* data = nullptr;     // data information about each node
-        bool visited = false;
-    };
-
-    struct EdgeNode
-    {
-        int adjGraphNode;  // subscript of the adjacent graph node
-        EdgeNode* nextEdge = nullptr;
-    };
-
-    GraphNode nodes[MAXNODES];
-    int size;
+    GraphStore store;              // graph nodes and edges
+    vector<bool> visited;          // whether node has been visited
+
+/* ----------------------- depthFirstVisit() ---------------------------
+   Description: recursive part of depthFirstHelper(), works on the
+   store's internal numbers
+   --------------------------------------------------------------------- */
+    void depthFirstVisit(int node);
 
 public:
 /* --------------------- Default Constructor ---------------------------
-   Description: initializes size to 0
-   --------------------------------------------------------------------- */
-    GraphL();
-/* -------------------------- Destructor -------------------------------
-   Description: releases memory dynamically allocated for EdgeNodes and
-   NodeDatas
+   Description: creates an empty unweighted store, compressed if asked,
+   whose nodes are numbered internally by ordering
    --------------------------------------------------------------------- */
-    ~GraphL();
+    explicit GraphL(bool compressed = false,
+                    GraphStore::Ordering ordering = GraphStore::INPUT);
 
 
 /* -------------------------- buildGraph() -----------------------------
@@ -72,11 +71,14 @@ public:
    rather than a search
    Displays the order of the graph when traversed depth-first starting
    from the first node
+   Clears the visited flags first, so it can be called more than once
    --------------------------------------------------------------------- */
     void depthFirstSearch();
 
 /* ----------------------- depthFirstHelper() --------------------------
-   Description: recursive helper function for depthFirstSearch()
+   Description: helper function for depthFirstSearch(), traverses the
+   unvisited nodes reachable from the node numbered currNode in the
+   input. Does nothing if that node is not in the graph
    --------------------------------------------------------------------- */
     void depthFirstHelper(int currNode);
 };
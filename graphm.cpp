@@ -1,22 +1,42 @@
 /** ------------------------- graphm.cpp -------------------------------
     Chaconne Tatum-Diehl 502A
     2/14/2019
-    2/18/2019
+    10/18/2026
     --------------------------------------------------------------------
     Purpose - Implementation file for the GraphM class, which implements
     a weighted digraph using an adjacency matrix.
     --------------------------------------------------------------------
-    GraphM uses a 2D array to represent connections between graph nodes
-    and an array of NodeData to store the data contained in the graph's
-    nodes.
+    GraphM keeps its nodes and edges in a weighted GraphStore, which
+    uses a cost matrix, CSR or both depending on how dense the graph is.
 
     An array of TableType helper structures is used to implement
-    Dijkstra's algorithm
-
-    No memory is dynamically allocated
+    Dijkstra's algorithm, which walks the edges of each visited node
+    through the store's neighbor view
+
+    Published Snapshots are never changed. Writers copy what they need
+    from the latest Snapshot, change the copy and publish it, Readers
+    load the current one. Only writers take writeLock, to keep two
+    edits from both starting from the same Snapshot and one of them
+    being lost. Replaced Snapshots are retired and freed by a later
+    writer once no Reader can hold them, stores and oracles are held by
+    shared_ptr so versions can share them
+
+    The epoch counters follow the Left-Right scheme. A Reader adds
+    itself to a counter before loading the pointer, so once a newer
+    pointer is stored, any Reader that can still hold a retired
+    Snapshot is counted. Seeing the other counter empty before switching
+    epochs, and the old one empty after, also catches Readers that read
+    the epoch before an earlier switch. Left-Right waits for each
+    counter, reclaim() instead checks it and tries again on the next
+    edit
 
     Uses stringstreams to easily convert between characters and integers
     when displaying graph contents
+
+    Node numbers are turned into the store's internal numbers where they
+    come in, and back where they are printed. When two nodes are equally
+    close, Dijkstra's algorithm visits the one with the lower input
+    number first, so paths do not depend on the ordering
     -------------------------------------------------------------------- */
 
 #include <climits>
@@ -32,46 +52,168 @@
 using namespace std;
 
 /* --------------------- Default Constructor ---------------------------
-   Description: zeros the size, TableType array, and cost array. Cost
-   array is "zeroed" by setting all values to -1, which is used as a
-   flag to indicate no connection
+   Description: publishes an empty graph with a zeroed TableType array.
+   ordering selects how buildGraph() numbers the nodes internally
+   --------------------------------------------------------------------- */
+GraphM::GraphM(GraphStore::Ordering ordering)
+    : ordering(ordering), current(nullptr), epoch(0), switched(false)
+{
+    readers[0] = 0;
+    readers[1] = 0;
+    publish(make_shared<GraphStore>(true, false, ordering), false, 0);
+}
+
+
+/* ---------------------------- Reader ---------------------------------
+   Description: adds a Reader to the current epoch, then loads the
+   current Snapshot
+   --------------------------------------------------------------------- */
+GraphM::Reader::Reader(const GraphM& graph)
+    : graph(graph), epoch(graph.epoch.load())
+{
+    graph.readers[epoch]++;
+    snapshot = graph.current.load();
+}
+
+
+/* ---------------------------- ~Reader --------------------------------
+   Description: removes the Reader from its epoch, after which the
+   Snapshot may be freed
    --------------------------------------------------------------------- */
-GraphM::GraphM() : size(0)
+GraphM::Reader::~Reader()
 {
-    //zero TableType array
-    zeroT();
+    graph.readers[epoch]--;
+}
+
 
-    //zero cost array
-    for(int i = 0; i < MAXNODES; i++)
+/* --------------------------- publish() -------------------------------
+   Description: makes a Snapshot for the given store, finding its
+   shortest paths first if computed is set, and publishes it. The
+   Snapshot it replaces is retired
+   Callers must hold writeLock
+   --------------------------------------------------------------------- */
+void GraphM::publish(shared_ptr<const GraphStore> store, bool computed,
+                     int landmarks, int from, int to)
+{
+    //the latest Snapshot is null only while constructing
+    shared_ptr<const Snapshot> old = latest;
+    bool sameStore = old && old->store == store;
+
+    shared_ptr<Snapshot> s = make_shared<Snapshot>();
+    s->store = store;
+    s->computed = computed;
+    s->landmarks = landmarks;
+    if(computed)
     {
-        for(int j = 0; j < MAXNODES; j++)
+        if(sameStore && old->computed)
         {
-            C[i][j] = -1;
+            s->T = old->T;
+        }
+        else if(from != 0 && old->computed)
+        {
+            s->T = old->T;
+            updatePaths(*s, from, to);
+        }
+        else
+        {
+            zeroTable(*s);
+            for(int source = 1; source <= store->getSize(); source++)
+            {
+                findPaths(*s, source);
+            }
         }
     }
+    if(landmarks > 0)
+    {
+        if(sameStore && old->landmarks == landmarks)
+        {
+            s->oracle = old->oracle;
+        }
+        else
+        {
+            s->oracle = make_shared<DistanceOracle>(*store, landmarks);
+        }
+    }
+    latest = s;
+    current = s.get();
+    if(old)
+    {
+        retired.push_back(old);
+    }
+    reclaim();
 }
 
 
-/* ---------------------------- zeroT() --------------------------------
-   Description: sets values in TableType array to defaults
+/* --------------------------- reclaim() -------------------------------
+   Description: frees the retired Snapshots no Reader can hold any more,
+   moving to the next epoch when the counters allow. Never waits
+   Callers must hold writeLock
    --------------------------------------------------------------------- */
-void GraphM::zeroT()
+void GraphM::reclaim()
 {
-    for(int i = 0; i < MAXNODES; i++)
+    for(;;)
     {
-        for(int j = 0; j < MAXNODES; j++)
+        //everything retired so far is freed together
+        if(draining.empty())
+        {
+            if(retired.empty())
+            {
+                return;
+            }
+            draining.swap(retired);
+            switched = false;
+        }
+
+        //before the switch, the epoch no new Reader joins must be empty
+        //after it, the epoch the Readers of draining joined must be
+        if(readers[epoch ^ 1] != 0)
+        {
+            return;
+        }
+        if(!switched)
         {
-            T[i][j].visited = false;
-            //INT_MAX used to represent infinity
-            T[i][j].dist = INT_MAX;
-            //no 0 node exists, so 0 is used here as a flag to indicate
-            //no previous pathway
-            T[i][j].path = 0;
+            epoch = epoch ^ 1;
+            switched = true;
+        }
+        else
+        {
+            draining.clear();
         }
     }
 }
 
 
+/* ------------------------- zeroTable() -------------------------------
+   Description: sets every entry of a Snapshot's TableType array to the
+   defaults. The array is left empty until paths are found, and an
+   empty array means there are no paths
+   --------------------------------------------------------------------- */
+void GraphM::zeroTable(Snapshot& s)
+{
+    TableType t;
+    t.visited = false;
+    //INT_MAX used to represent infinity
+    t.dist = INT_MAX;
+    //no 0 node exists, so 0 is used here as a flag to indicate
+    //no previous pathway
+    t.path = 0;
+
+    size_t rows = static_cast<size_t>(s.store->getSize()) + 1;
+    s.T.assign(rows * rows, t);
+}
+
+
+/* ---------------------------- zeroT() --------------------------------
+   Description: publishes the current graph with the TableType array
+   set to defaults
+   --------------------------------------------------------------------- */
+void GraphM::zeroT()
+{
+    lock_guard<mutex> guard(writeLock);
+    publish(latest->store, false, latest->landmarks);
+}
+
+
 /* -------------------------- buildGraph() -----------------------------
    Description: builds the graph given a text file containing the graph
    data
@@ -79,48 +221,56 @@ void GraphM::zeroT()
    --------------------------------------------------------------------- */
 void GraphM::buildGraph(ifstream& infile)
 {
-    infile >> size;
-    //discards newline
-    infile.get();
+    shared_ptr<GraphStore> store =
+        make_shared<GraphStore>(true, false, ordering);
+    store->buildGraph(infile);
 
-    //inserts a NodeData with the read in node name into the graph
-    for(int i = 1; i <= size; i++)
-    {
-        string temp;
-        getline(infile, temp);
-        NodeData n(temp);
-        data[i] = n;
-    }
-
-    int node1, node2, weight;
-    //stop if we reach end of file or read in a zero
-    while(infile >> node1 >> node2 >> weight)
-    {
-        if(node1 == 0)
-        {
-            break;
-        }
-        insertEdge(node1, node2, weight);
-    }
+    lock_guard<mutex> guard(writeLock);
+    publish(store, false, 0);
 }
 
 
 /* -------------------------- insertEdge() -----------------------------
-   Description: inserts an edge into the cost array of the graph
+   Description: inserts an edge into the graph, overwriting the weight
+   of an existing edge. Does nothing if either node is not in the graph
+   If shortest paths have been found they are updated before the new
+   graph is published
    --------------------------------------------------------------------- */
 void GraphM::insertEdge(int node1, int node2, int weight)
 {
-    C[node1][node2] = weight;
+    lock_guard<mutex> guard(writeLock);
+    //nodes that are not in the graph are ignored
+    if(!latest->store->hasNode(node1) || !latest->store->hasNode(node2))
+    {
+        return;
+    }
+    shared_ptr<GraphStore> store = make_shared<GraphStore>(*latest->store);
+    int from = store->getInternal(node1);
+    int to = store->getInternal(node2);
+    store->insertEdge(from, to, weight);
+    publish(store, latest->computed, latest->landmarks, from, to);
 }
 
 
 /* -------------------------- removeEdge() -----------------------------
-   Description: removes an edge into the cost array of the graph
-   -1 is used to indicate no connection
+   Description: removes an edge from the graph, the weight is ignored.
+   Does nothing if either node is not in the graph
+   If shortest paths have been found they are updated before the new
+   graph is published
    --------------------------------------------------------------------- */
 void GraphM::removeEdge(int node1, int node2, int weight)
 {
-    C[node1][node2] = -1;
+    lock_guard<mutex> guard(writeLock);
+    //nodes that are not in the graph are ignored
+    if(!latest->store->hasNode(node1) || !latest->store->hasNode(node2))
+    {
+        return;
+    }
+    shared_ptr<GraphStore> store = make_shared<GraphStore>(*latest->store);
+    int from = store->getInternal(node1);
+    int to = store->getInternal(node2);
+    store->removeEdge(from, to);
+    publish(store, latest->computed, latest->landmarks, from, to);
 }
 
 
@@ -130,48 +280,145 @@ void GraphM::removeEdge(int node1, int node2, int weight)
    --------------------------------------------------------------------- */
 void GraphM::findShortestPath()
 {
-    for (int source = 1; source <= size; source++)
+    lock_guard<mutex> guard(writeLock);
+    publish(latest->store, true, latest->landmarks);
+}
+
+
+/* ------------------------- buildOracle() -----------------------------
+   Description: prepares a DistanceOracle with the given number of
+   landmarks for distance(), which needs far less memory than
+   findShortestPath(). It is rebuilt when edges are inserted or
+   removed, a count of 0 drops it
+   --------------------------------------------------------------------- */
+void GraphM::buildOracle(int landmarks)
+{
+    lock_guard<mutex> guard(writeLock);
+    publish(latest->store, latest->computed, landmarks);
+}
+
+
+/* --------------------------- distance() ------------------------------
+   Description: returns bounds on the shortest distance from one node
+   to another, see DistanceOracle. Exact once findShortestPath() has
+   run, otherwise from the oracle, otherwise 0 and INT_MAX
+   --------------------------------------------------------------------- */
+DistanceOracle::Estimate GraphM::distance(int from, int to) const
+{
+    Reader s(*this);
+    int size = s->store->getSize();
+    DistanceOracle::Estimate e = {INT_MAX, INT_MAX};
+    //nodes that are not in the graph have no path between them
+    if(from < 1 || from > size || to < 1 || to > size)
+    {
+        return e;
+    }
+
+    int f = s->store->getInternal(from);
+    int t = s->store->getInternal(to);
+    if(s->computed)
+    {
+        e.lower = e.upper = s->at(f, t).dist;
+    }
+    else if(s->oracle)
+    {
+        e = s->oracle->distance(f, t);
+    }
+    else
+    {
+        e.lower = 0;
+    }
+    return e;
+}
+
+
+/* ------------------------- findPaths() -------------------------------
+   Description: runs Dijkstra's algorithm from one node of a Snapshot,
+   filling in its row of the TableType array
+   --------------------------------------------------------------------- */
+void GraphM::findPaths(Snapshot& s, int source)
+{
+    const GraphStore& store = *s.store;
+    int size = store.getSize();
+    for(int j = 1; j <= size; j++)
+    {
+        TableType& t = s.at(source, j);
+        t.visited = false;
+        t.dist = INT_MAX;
+        t.path = 0;
+    }
+
+    //distance between a node and itself is always 0
+    s.at(source, source).dist = 0;
+    for(int i = 1; i <= size; i++)
     {
-        //distance between a node and itself is always 0
-        T[source][source].dist = 0;
-        int currNode;
-        for(int i = 1; i <= size; i++)
+        //find next node to visit
+        int currNode = 0;
+        int shortest = INT_MAX;
+        for(int j = 1; j <= size; j++)
         {
-            //find next node to visit
-            int shortest = INT_MAX;
-            for(int j = 1; j <= size; j++)
+            const TableType& t = s.at(source, j);
+            //ties go to the lower input number, as without reordering
+            if(!t.visited && (t.dist < shortest ||
+               (t.dist == shortest && shortest != INT_MAX &&
+                store.getOriginal(j) < store.getOriginal(currNode))))
             {
-                if(!T[source][j].visited && T[source][j].dist < shortest)
-                {
-                    currNode = j;
-                    shortest = T[source][j].dist;
-                }
+                currNode = j;
+                shortest = t.dist;
             }
+        }
+
+        //every node reachable from the source has been visited
+        if(currNode == 0)
+        {
+            break;
+        }
 
-            //visit new node
-            T[source][currNode].visited = true;
+        //visit new node
+        TableType& curr = s.at(source, currNode);
+        curr.visited = true;
 
-            for(int k = 1; k <= size; k++)
+        for(GraphStore::Edge e : store.neighbors(currNode))
+        {
+            TableType& next = s.at(source, e.adjNode);
+            //if that path leads to an unvisited node and is shorter
+            //than the current shortest path between the source and it
+            if(!next.visited && next.dist > curr.dist + e.weight)
             {
-                //if a path to another unvisited node exists
-                if(C[currNode][k] != -1 && !T[source][k].visited)
-                {
-                    //if that path is shorter than the current shortest
-                    //path between the source and the new unvisited node
-                    if(T[source][k].dist >
-                       T[source][currNode].dist + C[currNode][k])
-                    {
-                        //update the TableType array with the new distance
-                        //and path data
-                        T[source][k].dist = T[source][currNode].dist
-                                            + C[currNode][k];
-                        T[source][k].path = currNode;
-                    }
-                }
+                //update the TableType array with the new distance
+                //and path data
+                next.dist = curr.dist + e.weight;
+                next.path = currNode;
             }
         }
     }
+}
 
+
+/* ------------------------ updatePaths() ------------------------------
+   Description: given a Snapshot holding the paths from before the edge
+   from one node to another was changed, finds the paths again from
+   each node whose path to the edge's end went through the edge or can
+   go through it now at no more cost. Other paths are unchanged, as
+   Dijkstra's algorithm from those nodes would only try the edge and
+   never keep it
+   --------------------------------------------------------------------- */
+void GraphM::updatePaths(Snapshot& s, int from, int to)
+{
+    int weight = s.store->getWeight(from, to);
+    for(int source = 1; source <= s.store->getSize(); source++)
+    {
+        const TableType& start = s.at(source, from);
+        const TableType& end = s.at(source, to);
+        bool used = end.path == from;
+        //an equal path may be chosen over the old one, so it counts
+        bool usable = weight != -1 && start.dist != INT_MAX &&
+            static_cast<long long>(start.dist) + weight <= end.dist;
+        if(used || usable)
+        {
+            findPaths(s, source);
+        }
+    }
 }
 
 
@@ -179,27 +426,33 @@ void GraphM::findShortestPath()
    Description: prints the graph, showing shortest paths between nodes
    (if they exist) and the weight of the path
    --------------------------------------------------------------------- */
-void GraphM::displayAll()
+void GraphM::displayAll() const
 {
-    cout << left << setw(26) << "Description" << setw(11) << "From node"
-         << setw(9) << "To node" << setw(12) << "Dijkstra's"
-         << setw(9) << "Path" << endl;
+    //one Snapshot is used for the whole table
+    Reader s(*this);
+    int size = s->store->getSize();
+    stringstream out;
+    out << left << setw(26) << "Description" << setw(11) << "From node"
+        << setw(9) << "To node" << setw(12) << "Dijkstra's"
+        << setw(9) << "Path" << endl;
 
     //displays the path from each node to each other node
     for(int i = 1; i <= size; i++)
     {
-        cout << setw(26) << data[i] << endl;
+        out << setw(26) << s->store->getData(s->store->getInternal(i))
+            << endl;
         for(int j = 1; j <= size; j++)
         {
             //does not display the path from a node to itself
             if(i != j)
             {
-                cout << setw(26) << "";
-                displayLine(i, j);
+                out << setw(26) << "";
+                displayLine(*s, i, j, out);
             }
         }
     }
-    cout << endl;
+    out << endl;
+    print(out);
 }
 
 
@@ -207,9 +460,12 @@ void GraphM::displayAll()
    Description: displays a the path and distance between two nodes, then
    displays the names of the nodes traversed
    --------------------------------------------------------------------- */
-void GraphM::display(int from, int to)
+void GraphM::display(int from, int to) const
 {
-    string pathstr = displayLine(from, to);
+    //the path and the names must come from the same Snapshot
+    Reader s(*this);
+    stringstream out;
+    string pathstr = displayLine(*s, from, to, out);
     stringstream ss(pathstr);
 
     //displays names of traversed nodes using the string containing the
@@ -217,9 +473,10 @@ void GraphM::display(int from, int to)
     int i;
     while(ss >> i)
     {
-        cout << data[i] << endl << endl;
+        out << s->store->getData(s->store->getInternal(i)) << endl << endl;
     }
-    cout << endl;
+    out << endl;
+    print(out);
 }
 
 
@@ -229,30 +486,52 @@ void GraphM::display(int from, int to)
    from one node to another and the nodes traversed on that path
    Returns the string indicating the path
    --------------------------------------------------------------------- */
-string GraphM::displayLine(int from, int to)
+string GraphM::displayLine(int from, int to) const
+{
+    stringstream out;
+    string pathstr = displayLine(*Reader(*this), from, to, out);
+    print(out);
+    return pathstr;
+}
+
+
+/* ------------------------ displayLine() ------------------------------
+   Description: displayLine() for a given Snapshot, writing the line to
+   out rather than cout
+   --------------------------------------------------------------------- */
+string GraphM::displayLine(const Snapshot& s, int from, int to,
+                           ostream& out)
 {
     stringstream ss;
     string pathstr = "";
     string temp = "";
 
-    cout << setw(11) << from << setw(9) << to << setw(12);
+    out << left << setw(11) << from << setw(9) << to << setw(12);
+
+    //nodes that are not in the graph have no path between them
+    int size = s.store->getSize();
+    bool inGraph = from >= 1 && from <= size && to >= 1 && to <= size;
+
+    //the table uses the store's internal numbers
+    int f = inGraph ? s.store->getInternal(from) : 0;
+    int t = inGraph ? s.store->getInternal(to) : 0;
 
     //if no path exists don't print distance or path
-    if(T[from][to].dist == INT_MAX)
+    if(!inGraph || s.T.empty() || s.at(f, t).dist == INT_MAX)
     {
-        cout << "---";
+        out << "---";
     }
     else
     {
-        cout << T[from][to].dist;
-        int c = to;
+        out << s.at(f, t).dist;
+        int c = t;
 
         //traverse backwards through the path, using a stringstream to
         //store the entire path as we go
         while(c != 0)
         {
-            ss << c << " ";
-            c = T[from][c].path;
+            ss << s.store->getOriginal(c) << " ";
+            c = s.at(f, c).path;
         }
 
         //reverse the backwards path to print in correct order
@@ -260,8 +539,21 @@ string GraphM::displayLine(int from, int to)
         {
             pathstr = temp + " " + pathstr;
         }
-        cout << setw(9) << pathstr;
+        out << setw(9) << pathstr;
     }
-    cout << endl;
+    out << endl;
     return pathstr;
 }
+
+
+/* ---------------------------- print() --------------------------------
+   Description: writes text formatted by a display function to cout in
+   one unformatted write, which leaves cout's width and flags alone so
+   display functions on other threads do not race on them
+   --------------------------------------------------------------------- */
+void GraphM::print(const stringstream& out)
+{
+    string text = out.str();
+    cout.write(text.data(), text.size());
+    cout.flush();
+}
@@ -1,30 +1,64 @@
 /** ------------------------- graphm.h ---------------------------------
     Chaconne Tatum-Diehl 502A
     2/14/2019
-    2/18/2019
+    10/18/2026
     --------------------------------------------------------------------
     Purpose - Header file for the GraphM class, which implements a
     weighted digraph using an adjacency matrix.
     --------------------------------------------------------------------
-    GraphM uses a 2D array to represent connections between graph nodes
-    and an array of NodeData to store the data contained in the graph's
-    nodes.
+    GraphM keeps its nodes and edges in a weighted GraphStore, which
+    uses a cost matrix, CSR or both depending on how dense the graph is.
 
     An array of TableType helper structures is used to implement
     Dijkstra's algorithm
+
+    The store and the TableType array are kept together in an immutable
+    Snapshot. Functions that change the graph or its paths build a new
+    Snapshot and publish it, so display functions can run on other
+    threads while edges are inserted or removed. Each display call works
+    on the one Snapshot it loaded. Display functions format their text
+    first and write it to cout in one piece
+
+    Readers are lock-free: a Reader adds itself to the counter of the
+    current epoch and loads the current Snapshot through an atomic
+    pointer, which never locks or waits. A writer publishes the new
+    pointer and retires the old Snapshot. Retired Snapshots are freed by
+    a later writer once new Readers have been moved to the other epoch
+    and both counters have been seen empty in turn, after which no
+    Reader can hold them. Writers only check the counters, so neither
+    side ever waits for the other, though all Readers of a graph update
+    the same two counters
+
+    When shortest paths have been found, an edit finds them again only
+    from the nodes whose paths used the changed edge or could use it
+
+    The nodes can be renumbered when the graph is built to improve
+    locality, see GraphStore::Ordering. The TableType array uses the
+    store's internal numbers, every public function takes and prints
+    the numbers from the input
+
+    For graphs too large for the TableType array, which takes size *
+    size entries, buildOracle() prepares a DistanceOracle instead, and
+    distance() answers with bounds on the shortest distance
     -------------------------------------------------------------------- */
 
 #ifndef GRAPHM_H
 #define GRAPHM_H
 
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "nodedata.h"
+#include "graphstore.h"
+#include "distanceoracle.h"
 
 using namespace std;
 
-const int MAXNODES = 256;
-
 class GraphM
 {
 private:
@@ -35,22 +69,124 @@ private:
         int path;              // previous node in path of min dist
     };
 
-    NodeData data[MAXNODES];              // data for graph nodes
-    int C[MAXNODES][MAXNODES];            // Cost array, the adjacency matrix
-    int size;                             // number of nodes in the graph
-    TableType T[MAXNODES][MAXNODES];      // stores visited, distance, path
+    struct Snapshot
+    {
+        shared_ptr<const GraphStore> store;   // graph nodes and edges
+        vector<TableType> T;                  // visited, distance, path
+        bool computed;                        // whether T holds the paths
+        int landmarks;                        // landmarks for the oracle
+        shared_ptr<const DistanceOracle> oracle;  // null if no landmarks
+
+        // entry for the path from one node to another
+        size_t cell(int from, int to) const
+        {
+            return static_cast<size_t>(from) * (store->getSize() + 1) + to;
+        }
+        TableType& at(int from, int to) { return T[cell(from, to)]; }
+        const TableType& at(int from, int to) const
+        {
+            return T[cell(from, to)];
+        }
+    };
+
+/* ---------------------------- Reader ---------------------------------
+   Description: a reader's hold on the latest published Snapshot, which
+   stays valid until the Reader is destroyed. Never locks or waits
+   --------------------------------------------------------------------- */
+    class Reader
+    {
+    public:
+        explicit Reader(const GraphM& graph);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const Snapshot& operator*() const { return *snapshot; }
+        const Snapshot* operator->() const { return snapshot; }
+
+    private:
+        const GraphM& graph;          // graph read from
+        int epoch;                    // counter this Reader added to
+        const Snapshot* snapshot;     // Snapshot loaded
+    };
+
+    GraphStore::Ordering ordering;        // node numbering for builds
+    shared_ptr<const Snapshot> latest;    // latest version, for writers
+    atomic<const Snapshot*> current;      // latest version, for Readers
+    mutable atomic<int> readers[2];       // Readers in each epoch
+    atomic<int> epoch;                    // epoch new Readers join
+    vector<shared_ptr<const Snapshot> > retired;   // replaced, not freed
+    vector<shared_ptr<const Snapshot> > draining;  // being freed
+    bool switched;                        // epoch moved since draining
+    mutex writeLock;                      // serializes writers only
+
+/* --------------------------- publish() -------------------------------
+   Description: makes a Snapshot for the given store, finding its
+   shortest paths first if computed is set and building an oracle if
+   landmarks is above 0, and publishes it. Paths and oracle are taken
+   from the latest Snapshot when it has the same store. When the store
+   differs from it only in the edge from one node to another, given by
+   their internal numbers, paths are found again only where needed
+   Callers must hold writeLock
+   --------------------------------------------------------------------- */
+    void publish(shared_ptr<const GraphStore> store, bool computed,
+                 int landmarks, int from = 0, int to = 0);
+
+/* --------------------------- reclaim() -------------------------------
+   Description: frees the retired Snapshots no Reader can hold any more,
+   moving to the next epoch when the counters allow. Never waits
+   Callers must hold writeLock
+   --------------------------------------------------------------------- */
+    void reclaim();
+
+/* ------------------------- zeroTable() -------------------------------
+   Description: sets every entry of a Snapshot's TableType array to the
+   defaults. The array is left empty until paths are found, and an
+   empty array means there are no paths
+   --------------------------------------------------------------------- */
+    static void zeroTable(Snapshot& s);
+
+/* ------------------------- findPaths() -------------------------------
+   Description: runs Dijkstra's algorithm from one node of a Snapshot,
+   filling in its row of the TableType array
+   --------------------------------------------------------------------- */
+    static void findPaths(Snapshot& s, int source);
+
+/* ------------------------ updatePaths() ------------------------------
+   Description: given a Snapshot holding the paths from before the edge
+   from one node to another was changed, finds the paths again from
+   each node whose path to the edge's end went through the edge or can
+   go through it now at no more cost. Other paths stay as they are
+   --------------------------------------------------------------------- */
+    static void updatePaths(Snapshot& s, int from, int to);
+
+/* ------------------------ displayLine() ------------------------------
+   Description: displayLine() for a given Snapshot, writing the line to
+   out rather than cout
+   --------------------------------------------------------------------- */
+    static string displayLine(const Snapshot& s, int from, int to,
+                              ostream& out);
+
+/* ---------------------------- print() --------------------------------
+   Description: writes text formatted by a display function to cout in
+   one unformatted write
+   --------------------------------------------------------------------- */
+    static void print(const stringstream& out);
 
 public:
 /* --------------------- Default Constructor ---------------------------
-   Description: zeros the size, TableType array, and cost array. Cost
-   array is "zeroed" by setting all values to -1, which is used as a
-   flag to indicate no connection
+   Description: publishes an empty graph with a zeroed TableType array.
+   ordering selects how buildGraph() numbers the nodes internally
    --------------------------------------------------------------------- */
-    GraphM();
+    explicit GraphM(GraphStore::Ordering ordering = GraphStore::INPUT);
+
+    GraphM(const GraphM&) = delete;
+    GraphM& operator=(const GraphM&) = delete;
 
 
 /* ---------------------------- zeroT() --------------------------------
-   Description: sets values in TableType array to defaults
+   Description: publishes the current graph with the TableType array
+   set to defaults
    --------------------------------------------------------------------- */
     void zeroT();
 
@@ -62,13 +198,18 @@ public:
     void buildGraph(ifstream& infile);
 
 /* -------------------------- insertEdge() -----------------------------
-   Description: inserts an edge into the cost array of the graph
+   Description: inserts an edge into the graph, overwriting the weight
+   of an existing edge. Does nothing if either node is not in the graph
+   If shortest paths have been found they are updated before the new
+   graph is published
    --------------------------------------------------------------------- */
     void insertEdge(int node1, int node2, int weight);
 
 /* -------------------------- removeEdge() -----------------------------
-   Description: removes an edge into the cost array of the graph
-   -1 is used to indicate no connection
+   Description: removes an edge from the graph, the weight is ignored.
+   Does nothing if either node is not in the graph
+   If shortest paths have been found they are updated before the new
+   graph is published
    --------------------------------------------------------------------- */
     void removeEdge(int node1, int node2, int weight);
 
@@ -78,17 +219,32 @@ public:
    --------------------------------------------------------------------- */
     void findShortestPath();
 
+/* ------------------------- buildOracle() -----------------------------
+   Description: prepares a DistanceOracle with the given number of
+   landmarks for distance(), which needs far less memory than
+   findShortestPath(). It is rebuilt when edges are inserted or
+   removed, a count of 0 drops it
+   --------------------------------------------------------------------- */
+    void buildOracle(int landmarks);
+
+/* --------------------------- distance() ------------------------------
+   Description: returns bounds on the shortest distance from one node
+   to another, see DistanceOracle. Exact once findShortestPath() has
+   run, otherwise from the oracle, otherwise 0 and INT_MAX
+   --------------------------------------------------------------------- */
+    DistanceOracle::Estimate distance(int from, int to) const;
+
 /* ------------------------ displayAll() -------------------------------
    Description: prints the graph, showing shortest paths between nodes
    (if they exist) and the weight of the path
    --------------------------------------------------------------------- */
-    void displayAll();
+    void displayAll() const;
 
 /* --------------------------- display() -------------------------------
    Description: displays a the path and distance between two nodes, then
    displays the names of the nodes traversed
    --------------------------------------------------------------------- */
-    void display(int from, int to);
+    void display(int from, int to) const;
 
 /* ------------------------ displayLine() ------------------------------
    Description: helper function for display() and displayAll() functions
@@ -96,7 +252,7 @@ public:
    from one node to another and the nodes traversed on that path
    Returns the string indicating the path
    --------------------------------------------------------------------- */
-    string displayLine(int from, int to);
+    string displayLine(int from, int to) const;
 };
 
 #endif // GRAPHM_H
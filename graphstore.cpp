@@ -0,0 +1,521 @@
+/** ----------------------- graphstore.cpp ------------------------------
+    10/18/2026
+    --------------------------------------------------------------------
+    Purpose - Implementation file for the GraphStore class, the shared
+    storage core behind GraphM and GraphL.
+    --------------------------------------------------------------------
+    Edges are read into a plain list first and laid out once all of them
+    are known, so the layout can be picked from the final edge density.
+
+    CSR rows are built with a counting sort on the from node, which
+    keeps the edges of each node in insertion order, and then reversed
+    so each row lists the most recently inserted edge first
+
+    Compressed rows are encoded from the CSR rows, which are then freed
+
+    Memory is managed by vectors, none is allocated by hand
+    -------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <string>
+#include <iostream>
+
+#include "graphstore.h"
+
+using namespace std;
+
+/* --------------------------- Constructor -----------------------------
+   Description: creates an empty store. weighted selects whether edges
+   in the input carry a weight, and matrix or list semantics for
+   repeated edges. compressed selects the COMPRESSED layout and
+   ordering how the nodes are numbered internally
+   --------------------------------------------------------------------- */
+GraphStore::GraphStore(bool weighted, bool compressed, Ordering ordering)
+    : weighted(weighted), compressed(compressed), ordering(ordering),
+    size(0), edgeCount(0), layout(compressed ? COMPRESSED : CSR), data(1),
+    internalId(1, 0), originalId(1, 0), offsets(2, 0){}
+
+
+/* -------------------------- buildGraph() -----------------------------
+   Description: reads the number of nodes, one name per line, then
+   "from to" or "from to weight" edges until a from of 0 or the end of
+   the file, then numbers the nodes and lays the edges out according to
+   their density
+   Does no input validation, relies on properly formatted input
+   --------------------------------------------------------------------- */
+void GraphStore::buildGraph(istream& infile)
+{
+    infile >> size;
+    //discards newline
+    infile.get();
+
+    //index 0 is unused so node numbers can be used as subscripts
+    data.assign(size + 1, NodeData());
+    for(int i = 1; i <= size; i++)
+    {
+        string temp;
+        getline(infile, temp);
+        data[i] = NodeData(temp);
+    }
+
+    vector<int> from;
+    vector<Edge> list;
+    Edge e;
+    int node;
+    //stop if we reach end of file or read in a zero
+    while(infile >> node >> e.adjNode)
+    {
+        //unweighted edges are one hop long
+        e.weight = 1;
+        if(weighted && !(infile >> e.weight))
+        {
+            break;
+        }
+        if(node == 0)
+        {
+            break;
+        }
+        from.push_back(node);
+        list.push_back(e);
+    }
+
+    relabel(from, list);
+    layoutGraph(from, list);
+}
+
+
+/* -------------------------- insertEdge() -----------------------------
+   Description: adds an edge, or overwrites its weight in a weighted
+   store. Updates the matrix in place when the layout is DENSE,
+   otherwise lays the graph out again
+   Does nothing if either node is not in the graph
+   --------------------------------------------------------------------- */
+void GraphStore::insertEdge(int from, int to, int weight)
+{
+    if(!hasNode(from) || !hasNode(to))
+    {
+        return;
+    }
+
+    if(layout == DENSE)
+    {
+        int& c = cost[cell(from, to)];
+        if(c == -1)
+        {
+            edgeCount++;
+        }
+        c = weight;
+        return;
+    }
+
+    vector<int> fromList;
+    vector<Edge> list;
+    collectEdges(fromList, list);
+    Edge e = {to, weighted ? weight : 1};
+    fromList.push_back(from);
+    list.push_back(e);
+    layoutGraph(fromList, list);
+}
+
+
+/* -------------------------- removeEdge() -----------------------------
+   Description: removes every edge from one node to another, does
+   nothing if there is none or either node is not in the graph
+   --------------------------------------------------------------------- */
+void GraphStore::removeEdge(int from, int to)
+{
+    if(!hasNode(from) || !hasNode(to) || getWeight(from, to) == -1)
+    {
+        return;
+    }
+
+    if(layout == DENSE)
+    {
+        cost[cell(from, to)] = -1;
+        edgeCount--;
+        return;
+    }
+
+    vector<int> fromList;
+    vector<Edge> list;
+    collectEdges(fromList, list);
+
+    //keeps every edge except those from one node to the other
+    int kept = 0;
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        if(fromList[i] != from || list[i].adjNode != to)
+        {
+            fromList[kept] = fromList[i];
+            list[kept] = list[i];
+            kept++;
+        }
+    }
+    fromList.resize(kept);
+    list.resize(kept);
+    layoutGraph(fromList, list);
+}
+
+
+/* --------------------------- getWeight() -----------------------------
+   Description: returns the weight of the edge from one node to another
+   or -1 if there is no such edge
+   --------------------------------------------------------------------- */
+int GraphStore::getWeight(int from, int to) const
+{
+    if(layout == COMPRESSED)
+    {
+        //rows are sorted by input number, so the search can stop early
+        int target = originalId[to];
+        for(Edge e : neighbors(from))
+        {
+            if(originalId[e.adjNode] >= target)
+            {
+                return e.adjNode == to ? e.weight : -1;
+            }
+        }
+        return -1;
+    }
+
+    if(layout != CSR)
+    {
+        return cost[cell(from, to)];
+    }
+
+    //rows list the newest edge first, which is the one that counts
+    for(int i = offsets[from]; i < offsets[from + 1]; i++)
+    {
+        if(edges[i].adjNode == to)
+        {
+            return edges[i].weight;
+        }
+    }
+    return -1;
+}
+
+
+/* -------------------------- layoutGraph() ----------------------------
+   Description: picks the layout for the given edges, listed in the
+   order they were inserted, and builds it
+   --------------------------------------------------------------------- */
+void GraphStore::layoutGraph(const vector<int>& from,
+                             const vector<Edge>& list)
+{
+    //counting sort on the from node, keeps insertion order within rows
+    vector<int> start(size + 2, 0);
+    for(size_t i = 0; i < from.size(); i++)
+    {
+        start[from[i] + 1]++;
+    }
+    for(int i = 1; i <= size + 1; i++)
+    {
+        start[i] += start[i - 1];
+    }
+    vector<Edge> sorted(list.size());
+    vector<int> next(start.begin(), start.end() - 1);
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        sorted[next[from[i]]++] = list[i];
+    }
+
+    //walks each row backwards so the newest edge comes first. A
+    //weighted store keeps only the newest edge to each node, seen[]
+    //holds the row last seen reaching that node
+    offsets.assign(size + 2, 0);
+    edges.clear();
+    edges.reserve(sorted.size());
+    vector<int> seen(size + 1, 0);
+    for(int row = 1; row <= size; row++)
+    {
+        offsets[row] = static_cast<int>(edges.size());
+        for(int i = start[row + 1] - 1; i >= start[row]; i--)
+        {
+            if(weighted)
+            {
+                if(seen[sorted[i].adjNode] == row)
+                {
+                    continue;
+                }
+                seen[sorted[i].adjNode] = row;
+            }
+            edges.push_back(sorted[i]);
+        }
+    }
+    offsets[size + 1] = static_cast<int>(edges.size());
+    edgeCount = static_cast<int>(edges.size());
+
+    if(compressed)
+    {
+        layout = COMPRESSED;
+        vector<int>().swap(cost);
+        compressRows();
+        return;
+    }
+
+    //picks the layout from the fraction of possible edges present
+    double density = size > 0
+        ? static_cast<double>(edgeCount) / (static_cast<double>(size) * size)
+        : 0.0;
+    if(density >= DENSE_DENSITY)
+    {
+        //a matrix can not keep the order of list semantics
+        layout = weighted ? DENSE : HYBRID;
+    }
+    else if(density >= SPARSE_DENSITY)
+    {
+        layout = HYBRID;
+    }
+    else
+    {
+        layout = CSR;
+    }
+
+    if(layout == CSR)
+    {
+        vector<int>().swap(cost);
+        return;
+    }
+
+    //fills the matrix from the rows, -1 is used to indicate no edge
+    size_t rows = static_cast<size_t>(size) + 1;
+    cost.assign(rows * rows, -1);
+    for(int row = 1; row <= size; row++)
+    {
+        //goes backwards so the newest of repeated edges is kept
+        for(int i = offsets[row + 1] - 1; i >= offsets[row]; i--)
+        {
+            cost[cell(row, edges[i].adjNode)] = edges[i].weight;
+        }
+    }
+
+    if(layout == DENSE)
+    {
+        vector<Edge>().swap(edges);
+        vector<int>().swap(offsets);
+    }
+}
+
+
+/* -------------------------- collectEdges() ---------------------------
+   Description: lists the current edges in insertion order, the inverse
+   of layoutGraph()
+   --------------------------------------------------------------------- */
+void GraphStore::collectEdges(vector<int>& from, vector<Edge>& list) const
+{
+    from.clear();
+    list.clear();
+    for(int row = 1; row <= size; row++)
+    {
+        //compressed rows are sorted, insertion order is already lost
+        if(layout == COMPRESSED)
+        {
+            for(Edge e : neighbors(row))
+            {
+                from.push_back(row);
+                list.push_back(e);
+            }
+            continue;
+        }
+
+        //rows are stored newest first, so they are read backwards
+        for(int i = offsets[row + 1] - 1; i >= offsets[row]; i--)
+        {
+            from.push_back(row);
+            list.push_back(edges[i]);
+        }
+    }
+}
+
+
+/* ---------------------------- relabel() ------------------------------
+   Description: numbers the nodes by the store's Ordering, and renumbers
+   the node data and the given edges to match
+   --------------------------------------------------------------------- */
+void GraphStore::relabel(vector<int>& from, vector<Edge>& list)
+{
+    //order lists the input numbers of the nodes in their new order
+    vector<int> order;
+    order.reserve(size);
+    for(int i = 1; i <= size; i++)
+    {
+        order.push_back(i);
+    }
+
+    if(ordering != INPUT)
+    {
+        //lists each node's neighbors with edges followed both ways
+        vector<int> start(size + 2, 0);
+        for(size_t i = 0; i < list.size(); i++)
+        {
+            start[from[i] + 1]++;
+            start[list[i].adjNode + 1]++;
+        }
+        for(int i = 1; i <= size + 1; i++)
+        {
+            start[i] += start[i - 1];
+        }
+        vector<int> adj(start[size + 1]);
+        vector<int> next(start.begin(), start.end() - 1);
+        for(size_t i = 0; i < list.size(); i++)
+        {
+            adj[next[from[i]]++] = list[i].adjNode;
+            adj[next[list[i].adjNode]++] = from[i];
+        }
+        auto degree = [&start](int n) { return start[n + 1] - start[n]; };
+        auto fewerEdges = [&degree](int a, int b)
+        {
+            return degree(a) < degree(b);
+        };
+
+        if(ordering == DEGREE)
+        {
+            stable_sort(order.begin(), order.end(), [&degree](int a, int b)
+            {
+                return degree(a) > degree(b);
+            });
+        }
+        else
+        {
+            //RCM starts each connected piece from its node of least
+            //degree, BFS from its lowest numbered node
+            vector<int> seeds(order);
+            if(ordering == RCM)
+            {
+                stable_sort(seeds.begin(), seeds.end(), fewerEdges);
+            }
+
+            order.clear();
+            vector<bool> placed(size + 1, false);
+            for(int seed : seeds)
+            {
+                if(placed[seed])
+                {
+                    continue;
+                }
+                placed[seed] = true;
+                order.push_back(seed);
+                //order doubles as the queue, head is the next to expand
+                for(size_t head = order.size() - 1; head < order.size();
+                    head++)
+                {
+                    int n = order[head];
+                    size_t first = order.size();
+                    for(int i = start[n]; i < start[n + 1]; i++)
+                    {
+                        if(!placed[adj[i]])
+                        {
+                            placed[adj[i]] = true;
+                            order.push_back(adj[i]);
+                        }
+                    }
+                    if(ordering == RCM)
+                    {
+                        stable_sort(order.begin() + first, order.end(),
+                                    fewerEdges);
+                    }
+                }
+            }
+            if(ordering == RCM)
+            {
+                reverse(order.begin(), order.end());
+            }
+        }
+    }
+
+    internalId.assign(size + 1, 0);
+    originalId.assign(size + 1, 0);
+    for(int i = 0; i < size; i++)
+    {
+        originalId[i + 1] = order[i];
+        internalId[order[i]] = i + 1;
+    }
+    if(ordering == INPUT)
+    {
+        return;
+    }
+
+    vector<NodeData> renumbered(size + 1);
+    for(int i = 1; i <= size; i++)
+    {
+        renumbered[internalId[i]] = data[i];
+    }
+    data.swap(renumbered);
+    for(size_t i = 0; i < list.size(); i++)
+    {
+        from[i] = internalId[from[i]];
+        list[i].adjNode = internalId[list[i].adjNode];
+    }
+}
+
+
+/* ------------------------- compressRows() ----------------------------
+   Description: sorts each CSR row by input number and encodes it into
+   codes, then frees the CSR edges
+   --------------------------------------------------------------------- */
+void GraphStore::compressRows()
+{
+    codes.clear();
+    vector<int> values;
+    for(int row = 1; row <= size; row++)
+    {
+        Edge* first = edges.data() + offsets[row];
+        Edge* last = edges.data() + offsets[row + 1];
+        sort(first, last, [this](const Edge& a, const Edge& b)
+        {
+            return originalId[a.adjNode] < originalId[b.adjNode];
+        });
+
+        values.clear();
+        int prev = 0;
+        for(Edge* e = first; e != last; e++)
+        {
+            //zigzag, so small steps either way take one byte
+            int delta = e->adjNode - prev;
+            values.push_back(delta >= 0 ? 2 * delta : -2 * delta - 1);
+            if(weighted)
+            {
+                values.push_back(e->weight);
+            }
+            prev = e->adjNode;
+        }
+        offsets[row] = static_cast<int>(codes.size());
+        writeGroups(values);
+    }
+    offsets[size + 1] = static_cast<int>(codes.size());
+    vector<Edge>().swap(edges);
+
+    //the last value may be read as four bytes, so three more are added
+    codes.resize(codes.size() + 3, 0);
+    //the rows are not added to again until the next layout
+    codes.shrink_to_fit();
+}
+
+
+/* ------------------------- writeGroups() -----------------------------
+   Description: appends values to codes as group varints. Each group of
+   up to four values starts with a tag byte whose two bit fields, from
+   the lowest, hold each value's byte length minus one
+   --------------------------------------------------------------------- */
+void GraphStore::writeGroups(const vector<int>& values)
+{
+    for(size_t i = 0; i < values.size(); i += 4)
+    {
+        size_t tagAt = codes.size();
+        codes.push_back(0);
+        for(size_t j = i; j < values.size() && j < i + 4; j++)
+        {
+            unsigned int v = static_cast<unsigned int>(values[j]);
+            int length = 1;
+            while(length < 4 && (v >> (8 * length)) != 0)
+            {
+                length++;
+            }
+            codes[tagAt] |= static_cast<unsigned char>((length - 1)
+                                                       << (2 * (j - i)));
+            for(int b = 0; b < length; b++)
+            {
+                codes.push_back(static_cast<unsigned char>(v >> (8 * b)));
+            }
+        }
+    }
+}
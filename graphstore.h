@@ -0,0 +1,341 @@
+/** ------------------------ graphstore.h -------------------------------
+    10/18/2026
+    --------------------------------------------------------------------
+    Purpose - Header file for the GraphStore class, the shared storage
+    core behind GraphM and GraphL.
+    --------------------------------------------------------------------
+    GraphStore reads the node names and edges of a graph and then picks
+    how to lay the edges out in memory from the edge density:
+
+      DENSE  - a (size + 1) x (size + 1) cost matrix, -1 for no edge
+      CSR    - compressed sparse rows: an offset per node into one
+               contiguous array of edges
+      HYBRID - both of the above, CSR is used for walking neighbors and
+               the matrix for constant time edge lookups
+
+    A store can also be asked to compress its edges, in which case the
+    COMPRESSED layout is used whatever the density. Each node's
+    neighbors are sorted by their number in the input and stored as the
+    difference from the previous neighbor's internal number, zigzag
+    encoded (0, -1, 1, -2 as 0, 1, 2, 3) since an Ordering can make it
+    negative, followed by the weight in a weighted store. These values
+    are written with group varint: a tag byte holding the byte length
+    (1 to 4) of the next four values, then the values in as many bytes,
+    lowest byte first. Decoding needs no branch per byte, unlike a
+    varint that marks its last byte. Rows start a new group, and codes
+    ends with padding so a value can always be read as four bytes.
+    Neighbors of a compressed store are given in increasing input number
+    order, so output does not depend on the Ordering
+
+    Read-only access is given through getWeight() and neighbors(), which
+    hide the layout so callers always walk the cheapest one available.
+
+    A weighted store has matrix semantics: inserting an edge that
+    already exists overwrites its weight. An unweighted store has list
+    semantics: repeated edges are kept, and each node's neighbors are
+    given most recently inserted first, the same order a linked
+    adjacency list built by inserting at the head would give. Since a
+    matrix can not keep that order, an unweighted store never uses the
+    DENSE layout on its own.
+
+    Nodes are numbered from 1 to size, index 0 is unused
+
+    buildGraph() can relabel the nodes so that nodes used together are
+    stored close together, see Ordering. The store works in these new
+    internal numbers, callers turn the numbers in the input, and those
+    shown to users, to internal ones with getInternal() and back with
+    getOriginal(). Edits after buildGraph() keep the same labels
+    -------------------------------------------------------------------- */
+
+#ifndef GRAPHSTORE_H
+#define GRAPHSTORE_H
+
+#include <iostream>
+#include <vector>
+
+#include "nodedata.h"
+
+using namespace std;
+
+// density (edges / size^2) at or above which the matrix is used alone
+const double DENSE_DENSITY = 0.5;
+// density below which CSR is used alone
+const double SPARSE_DENSITY = 0.05;
+
+class GraphStore
+{
+public:
+    enum Layout { DENSE, CSR, HYBRID, COMPRESSED };
+
+    // how buildGraph() numbers the nodes internally
+    //   INPUT  - as in the input
+    //   BFS    - in breadth-first order, edges followed both ways
+    //   RCM    - reverse Cuthill-McKee, a breadth-first order starting
+    //            from a node of low degree that visits neighbors of low
+    //            degree first, then reversed, which keeps the edges of
+    //            each node close to the diagonal of the matrix
+    //   DEGREE - most edges first, so the busiest nodes share cache
+    // Only walks over the edges, like depthFirstSearch(), get faster.
+    // GraphM's findShortestPath() scans whole rows of its table to pick
+    // each next node, which costs the same in any order
+    enum Ordering { INPUT, BFS, RCM, DEGREE };
+
+    struct Edge
+    {
+        int adjNode;           // subscript of the adjacent node
+        int weight;            // cost of the edge, 1 if unweighted
+    };
+
+/* ------------------------- NeighborIterator --------------------------
+   Description: forward iterator over the edges leaving one node. Walks
+   the CSR edges when the layout has them, decodes the group varints of
+   a compressed row, otherwise scans the node's row of the cost matrix
+   skipping the -1 entries
+   --------------------------------------------------------------------- */
+    class NeighborIterator
+    {
+    public:
+        Edge operator*() const
+        {
+            if(edge)
+            {
+                return *edge;
+            }
+            if(code)
+            {
+                return curr;
+            }
+            Edge e = {col, row[col]};
+            return e;
+        }
+
+        NeighborIterator& operator++()
+        {
+            if(edge)
+            {
+                ++edge;
+            }
+            else if(code)
+            {
+                code = after;
+                decode();
+            }
+            else
+            {
+                col = nextCol(col + 1);
+            }
+            return *this;
+        }
+
+        bool operator!=(const NeighborIterator& rhs) const
+        {
+            return edge != rhs.edge || code != rhs.code || col != rhs.col;
+        }
+
+    private:
+        friend class GraphStore;
+
+        //reads the next value of the group, moving after past it
+        int readValue()
+        {
+            if(slot == 0)
+            {
+                tag = *after++;
+            }
+            int length = ((tag >> (2 * slot)) & 3) + 1;
+            unsigned int value = after[0] | after[1] << 8 |
+                after[2] << 16 | static_cast<unsigned int>(after[3]) << 24;
+            //keeps only the bytes that belong to this value
+            value &= 0xffffffffu >> (32 - 8 * length);
+            after += length;
+            slot = (slot + 1) & 3;
+            return static_cast<int>(value);
+        }
+
+        //decodes the entry at code into curr, unless at the row's end
+        void decode()
+        {
+            if(code == stop)
+            {
+                return;
+            }
+            after = code;
+            //undoes the zigzag encoding of the difference
+            int delta = readValue();
+            curr.adjNode += (delta >> 1) ^ -(delta & 1);
+            curr.weight = weighted ? readValue() : 1;
+        }
+
+        //first column at or after c holding an edge, or last if none
+        int nextCol(int c) const
+        {
+            while(c < last && row[c] == -1)
+            {
+                c++;
+            }
+            return c;
+        }
+
+        const Edge* edge = nullptr;   // CSR cursor, null when scanning
+        const int* row = nullptr;     // matrix row, null when using CSR
+        int col = 0;                  // current column of the row
+        int last = 0;                 // one past the last column
+        const unsigned char* code = nullptr;  // current compressed entry
+        const unsigned char* after = nullptr; // entry after the current
+        const unsigned char* stop = nullptr;  // end of the compressed row
+        Edge curr = {0, 0};           // decoded current entry
+        int tag = 0;                  // tag byte of the current group
+        int slot = 0;                 // next value's place in the group
+        bool weighted = false;        // whether entries hold a weight
+    };
+
+    struct NeighborRange
+    {
+        NeighborIterator first;
+        NeighborIterator last;
+
+        NeighborIterator begin() const { return first; }
+        NeighborIterator end() const { return last; }
+    };
+
+/* --------------------------- Constructor -----------------------------
+   Description: creates an empty store. weighted selects whether edges
+   in the input carry a weight, and matrix or list semantics for
+   repeated edges. compressed selects the COMPRESSED layout and
+   ordering how the nodes are numbered internally
+   --------------------------------------------------------------------- */
+    explicit GraphStore(bool weighted, bool compressed = false,
+                        Ordering ordering = INPUT);
+
+/* -------------------------- buildGraph() -----------------------------
+   Description: reads the number of nodes, one name per line, then
+   "from to" or "from to weight" edges until a from of 0 or the end of
+   the file, then lays the edges out according to their density
+   Does no input validation, relies on properly formatted input
+   --------------------------------------------------------------------- */
+    void buildGraph(istream& infile);
+
+/* -------------------------- insertEdge() -----------------------------
+   Description: adds an edge, or overwrites its weight in a weighted
+   store. Updates the matrix in place when the layout is DENSE,
+   otherwise lays the graph out again
+   Does nothing if either node is not in the graph
+   --------------------------------------------------------------------- */
+    void insertEdge(int from, int to, int weight);
+
+/* -------------------------- removeEdge() -----------------------------
+   Description: removes every edge from one node to another, does
+   nothing if there is none or either node is not in the graph
+   --------------------------------------------------------------------- */
+    void removeEdge(int from, int to);
+
+/* --------------------------- getWeight() -----------------------------
+   Description: returns the weight of the edge from one node to another
+   or -1 if there is no such edge
+   --------------------------------------------------------------------- */
+    int getWeight(int from, int to) const;
+
+/* --------------------------- neighbors() -----------------------------
+   Description: returns a read-only range over the edges leaving a node
+   --------------------------------------------------------------------- */
+    NeighborRange neighbors(int node) const
+    {
+        NeighborRange r;
+        if(layout == DENSE)
+        {
+            const int* row = &cost[cell(node, 0)];
+            r.first.row = r.last.row = row;
+            r.first.last = r.last.last = size + 1;
+            r.last.col = size + 1;
+            r.first.col = r.first.nextCol(1);
+        }
+        else if(layout == COMPRESSED)
+        {
+            r.first.code = codes.data() + offsets[node];
+            r.last.code = r.first.stop = codes.data() + offsets[node + 1];
+            r.first.weighted = weighted;
+            r.first.decode();
+        }
+        else
+        {
+            r.first.edge = edges.data() + offsets[node];
+            r.last.edge = edges.data() + offsets[node + 1];
+        }
+        return r;
+    }
+
+/* --------------------------- getters ---------------------------------
+   Description: number of nodes, number of edges, the layout chosen for
+   the edges and the data of a node
+   --------------------------------------------------------------------- */
+    int getSize() const { return size; }
+    bool hasNode(int node) const { return node >= 1 && node <= size; }
+    int getEdgeCount() const { return edgeCount; }
+    Layout getLayout() const { return layout; }
+    const NodeData& getData(int node) const { return data[node]; }
+
+/* ------------------------ getInternal() ------------------------------
+   Description: internal number of the node numbered id in the input
+   --------------------------------------------------------------------- */
+    int getInternal(int id) const { return internalId[id]; }
+
+/* ------------------------ getOriginal() ------------------------------
+   Description: number in the input of the node numbered node internally
+   --------------------------------------------------------------------- */
+    int getOriginal(int node) const { return originalId[node]; }
+
+private:
+/* ----------------------------- cell() --------------------------------
+   Description: index of an entry of the cost matrix, worked out in
+   size_t since the matrix can have more than INT_MAX entries
+   --------------------------------------------------------------------- */
+    size_t cell(int from, int to) const
+    {
+        return static_cast<size_t>(from) * (size + 1) + to;
+    }
+
+/* -------------------------- layoutGraph() ----------------------------
+   Description: picks the layout for the given edges, listed in the
+   order they were inserted, and builds it
+   --------------------------------------------------------------------- */
+    void layoutGraph(const vector<int>& from, const vector<Edge>& list);
+
+/* -------------------------- collectEdges() ---------------------------
+   Description: lists the current edges in insertion order, the inverse
+   of layoutGraph()
+   --------------------------------------------------------------------- */
+    void collectEdges(vector<int>& from, vector<Edge>& list) const;
+
+/* ---------------------------- relabel() ------------------------------
+   Description: numbers the nodes by the store's Ordering, and renumbers
+   the node data and the given edges to match
+   --------------------------------------------------------------------- */
+    void relabel(vector<int>& from, vector<Edge>& list);
+
+/* ------------------------- compressRows() ----------------------------
+   Description: sorts each CSR row by input number and encodes it into
+   codes, then frees the CSR edges
+   --------------------------------------------------------------------- */
+    void compressRows();
+
+/* ------------------------- writeGroups() -----------------------------
+   Description: appends values to codes as group varints
+   --------------------------------------------------------------------- */
+    void writeGroups(const vector<int>& values);
+
+    bool weighted;                // edges carry weights from the input
+    bool compressed;              // always use the COMPRESSED layout
+    Ordering ordering;            // how buildGraph() numbers the nodes
+    int size;                     // number of nodes in the graph
+    int edgeCount;                // number of edges in the graph
+    Layout layout;                // how the edges are laid out
+    vector<NodeData> data;        // data for graph nodes
+    vector<int> internalId;       // internal number by input number
+    vector<int> originalId;       // input number by internal number
+    vector<int> cost;             // cost matrix, DENSE and HYBRID only
+    vector<int> offsets;          // row starts, all but DENSE
+    vector<Edge> edges;           // CSR edges, CSR and HYBRID only
+    vector<unsigned char> codes;  // group varint rows, COMPRESSED only
+};
+
+#endif // GRAPHSTORE_H
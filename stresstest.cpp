@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------
+// stresstest.cpp
+//---------------------------------------------------------------------------
+// This code checks that GraphM can be read from several threads while
+// other threads insert and remove edges. Readers call display(),
+// displayAll(), displayLine() and distance() in a loop while writers keep
+// changing the edge from node 1 to node 2 of the first graph in
+// data31.txt between three versions:
+//   -- the edge as read, weight 50
+//   -- the edge with weight 1
+//   -- no edge
+// Every read must match what one of these versions gives on its own,
+// a read that mixes two versions or is cut short is counted as bad.
+//
+// Build and run from this directory with, for example:
+//   g++ -std=c++17 -pthread graphm.cpp graphstore.cpp distanceoracle.cpp
+//       nodedata.cpp stresstest.cpp -o stresstest && ./stresstest
+// adding -fsanitize=thread to also check for data races.
+//
+// Assumptions:
+//   -- text file "data31.txt" is formatted as described for lab3.cpp
+//   -- returns 0 if every read was valid, 1 otherwise
+//---------------------------------------------------------------------------
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "graphm.h"
+using namespace std;
+
+const int READERS = 4;         // threads reading the graph
+const int WRITERS = 2;         // threads changing the graph
+const int EDITS = 3000;        // edits made by each writer
+
+// the edits that make each version from any other, as (weight, insert)
+const int VERSIONS = 3;
+const int WEIGHT[VERSIONS] = {50, 1, 0};
+const bool INSERT[VERSIONS] = {true, true, false};
+
+//---------------------------------------------------------------------------
+// ThreadBuffer collects what each thread writes to cout separately, so a
+// reader can check the text of its own display call. GraphM writes each
+// display in one piece, which arrives here through xsputn()
+class ThreadBuffer : public streambuf {
+public:
+	// takes and clears the text written by the calling thread
+	static string take() {
+		string text;
+		text.swap(written);
+		return text;
+	}
+
+protected:
+	streamsize xsputn(const char* s, streamsize n) override {
+		written.append(s, n);
+		return n;
+	}
+
+	int overflow(int c) override {
+		if (c != EOF)
+			written.push_back(static_cast<char>(c));
+		return c;
+	}
+
+private:
+	static thread_local string written;
+};
+
+thread_local string ThreadBuffer::written;
+
+//---------------------------------------------------------------------------
+// Valid holds, for each read, every result one of the versions gives
+struct Valid {
+	set<string> display12, display31, displayAll, line12, path12;
+	set<pair<int, int> > dist12, dist14;
+};
+
+//---------------------------------------------------------------------------
+// readGraph: builds the first graph of data31.txt into G
+bool readGraph(GraphM& G) {
+	ifstream infile("data31.txt");
+	if (!infile)
+		return false;
+	G.buildGraph(infile);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// edit: changes the edge from node 1 to node 2 into the given version
+void edit(GraphM& G, int version) {
+	if (INSERT[version])
+		G.insertEdge(1, 2, WEIGHT[version]);
+	else
+		G.removeEdge(1, 2, 0);
+}
+
+//---------------------------------------------------------------------------
+// record: adds what each read gives on G to valid, G is not being changed
+void record(const GraphM& G, Valid& valid) {
+	G.display(1, 2);
+	valid.display12.insert(ThreadBuffer::take());
+	G.display(3, 1);
+	valid.display31.insert(ThreadBuffer::take());
+	G.displayAll();
+	valid.displayAll.insert(ThreadBuffer::take());
+	valid.path12.insert(G.displayLine(1, 2));
+	valid.line12.insert(ThreadBuffer::take());
+
+	DistanceOracle::Estimate e = G.distance(1, 2);
+	valid.dist12.insert(make_pair(e.lower, e.upper));
+	e = G.distance(1, 4);
+	valid.dist14.insert(make_pair(e.lower, e.upper));
+}
+
+//---------------------------------------------------------------------------
+// check: makes each read once on G, which may be changing, and returns
+// the number of reads that match none of the versions
+int check(const GraphM& G, const Valid& valid) {
+	int bad = 0;
+	G.display(1, 2);
+	bad += valid.display12.count(ThreadBuffer::take()) == 0;
+	G.display(3, 1);
+	bad += valid.display31.count(ThreadBuffer::take()) == 0;
+	G.displayAll();
+	bad += valid.displayAll.count(ThreadBuffer::take()) == 0;
+	bad += valid.path12.count(G.displayLine(1, 2)) == 0;
+	bad += valid.line12.count(ThreadBuffer::take()) == 0;
+
+	DistanceOracle::Estimate e = G.distance(1, 2);
+	bad += valid.dist12.count(make_pair(e.lower, e.upper)) == 0;
+	e = G.distance(1, 4);
+	bad += valid.dist14.count(make_pair(e.lower, e.upper)) == 0;
+	return bad;
+}
+
+int main() {
+	ThreadBuffer buffer;
+	streambuf* console = cout.rdbuf(&buffer);
+
+	// record every version on its own first
+	Valid valid;
+	for (int v = 0; v < VERSIONS; v++) {
+		GraphM G;
+		if (!readGraph(G)) {
+			cout.rdbuf(console);
+			cout << "File could not be opened." << endl;
+			return 1;
+		}
+		edit(G, v);
+		G.findShortestPath();
+		record(G, valid);
+	}
+
+	GraphM G;
+	readGraph(G);
+	G.findShortestPath();
+
+	atomic<bool> done(false);
+	atomic<long> reads(0), bad(0);
+	vector<thread> writers, readers;
+	for (int r = 0; r < READERS; r++) {
+		readers.emplace_back([&]() {
+			//reads at least once after the writers have finished
+			bool last = false;
+			while (!last) {
+				last = done;
+				bad += check(G, valid);
+				reads++;
+			}
+		});
+	}
+	for (int w = 0; w < WRITERS; w++) {
+		writers.emplace_back([&, w]() {
+			for (int i = 0; i < EDITS; i++)
+				edit(G, (i + w) % VERSIONS);
+		});
+	}
+
+	for (size_t i = 0; i < writers.size(); i++)
+		writers[i].join();
+	done = true;
+	for (size_t i = 0; i < readers.size(); i++)
+		readers[i].join();
+
+	cout.rdbuf(console);
+	cout << WRITERS * EDITS << " edits, " << reads << " rounds of reads, "
+	     << bad << " bad reads" << endl;
+	return bad == 0 ? 0 : 1;
+}